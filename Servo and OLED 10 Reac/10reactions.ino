@@ -27,6 +27,7 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <ESP32Servo.h>
+#include "ConnectionManager.h" // same class as mentora_main.ino/, kept identical
 
 // WiFi credentials - Change these to your network
 const char* ssid = "kkk";
@@ -64,6 +65,14 @@ String baseEmotion = "DEFAULT"; // The underlying emotion without reaction
 bool hasReaction = false;
 unsigned long lastCommandTime = 0;
 bool wifiConnected = false;
+
+// Non-blocking WiFi state machine (stepped from checkWiFiConnection every loop)
+ConnectionManager connection;
+
+// Status screens (IP, connection lost) hold the OLED for STATUS_SCREEN_DURATION
+bool statusScreenActive = false;
+unsigned long statusScreenStart = 0;
+const unsigned long STATUS_SCREEN_DURATION = 3000;
 unsigned long lastEyeUpdate = 0;
 int eyeState = 0;
 bool eyeOpen = true;
@@ -94,6 +103,8 @@ void initializeDisplay();
 void initializeRoboEyes();
 void connectToWiFi();
 void checkWiFiConnection();
+void displayWiFiConnected();
+void holdStatusScreen();
 void setupWebServer();
 void setEmotion(String emotion);
 void displayEmotion();
@@ -148,8 +159,10 @@ void loop() {
   // Handle web server requests
   server.handleClient();
   
-  // Update RoboEyes animations (only when not doing special animations)
-  if (!isYesNoAnimation && !isReactionAnimation) {
+  // Update RoboEyes animations (only when not doing special animations or showing a status screen)
+  // Elapsed-time compare stays correct across the millis() wrap
+  if (statusScreenActive && millis() - statusScreenStart >= STATUS_SCREEN_DURATION) statusScreenActive = false;
+  if (!isYesNoAnimation && !isReactionAnimation && !statusScreenActive) {
     roboEyes.update();
   }
   
@@ -195,80 +208,56 @@ void initializeRoboEyes() {
 }
 
 void connectToWiFi() {
-  // Show connecting message on display
+  // Show connecting message on display; the connection completes in checkWiFiConnection()
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(SSD1306_WHITE);
   display.setCursor(0, 0);
   display.println("Connecting to WiFi...");
   display.display();
-  
-  WiFi.begin(ssid, password);
-  Serial.print("Connecting to WiFi");
-  
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 30) {
-    delay(1000);
-    Serial.print(".");
-    attempts++;
-    
-    // Show progress dots
-    display.print(".");
-    display.display();
-  }
-  
-  if (WiFi.status() == WL_CONNECTED) {
+  holdStatusScreen();
+
+  connection.begin(ssid, password);
+  Serial.println("Connecting to WiFi...");
+}
+
+void checkWiFiConnection() {
+  connection.update();
+
+  if (connection.justConnected()) {
     wifiConnected = true;
-    Serial.println();
     Serial.print("Connected! IP address: ");
     Serial.println(WiFi.localIP());
-    
-    // Show IP address
-    display.clearDisplay();
-    display.setCursor(0, 0);
-    display.println("WiFi Connected!");
-    display.setCursor(0, 15);
-    display.println("IP Address:");
-    display.setCursor(0, 25);
-    display.println(WiFi.localIP().toString());
-    display.setCursor(0, 45);
-    display.println("Ready for commands!");
-    display.display();
-    delay(3000); // Show IP for 3 seconds
-    
-  } else {
+    displayWiFiConnected();
+  }
+
+  if (connection.justDisconnected()) {
     wifiConnected = false;
-    Serial.println();
-    Serial.println("WiFi connection failed!");
-    
-    display.clearDisplay();
-    display.setCursor(0, 0);
-    display.println("WiFi Failed!");
-    display.setCursor(0, 15);
-    display.println("Check credentials");
-    display.setCursor(0, 30);
-    display.println("in code and");
-    display.setCursor(0, 40);
-    display.println("restart ESP32");
-    display.display();
-    delay(5000);
+    Serial.println("WiFi connection lost! Retry in " + String(connection.getRetryInMs()) + " ms");
+    displayConnectionLost();
   }
 }
 
-void checkWiFiConnection() {
-  static unsigned long lastCheck = 0;
-  if (millis() - lastCheck > 10000) { // Check every 10 seconds
-    lastCheck = millis();
-    
-    if (WiFi.status() != WL_CONNECTED && wifiConnected) {
-      wifiConnected = false;
-      Serial.println("WiFi connection lost!");
-      displayConnectionLost();
-    } else if (WiFi.status() == WL_CONNECTED && !wifiConnected) {
-      wifiConnected = true;
-      Serial.println("WiFi reconnected!");
-    }
-  }
+void displayWiFiConnected() {
+  // Show IP address; the eyes resume once the status screen expires
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(0, 0);
+  display.println("WiFi Connected!");
+  display.setCursor(0, 15);
+  display.println("IP Address:");
+  display.setCursor(0, 25);
+  display.println(WiFi.localIP().toString());
+  display.setCursor(0, 45);
+  display.println("Ready for commands!");
+  display.display();
+  holdStatusScreen();
+}
+
+void holdStatusScreen() {
+  statusScreenActive = true;
+  statusScreenStart = millis();
 }
 
 void setupWebServer() {
@@ -992,6 +981,7 @@ void displayConnectionLost() {
   display.fillCircle(85, 40, 4, SSD1306_BLACK);
   
   display.display();
+  holdStatusScreen();
 }
 
 void nodYes() {
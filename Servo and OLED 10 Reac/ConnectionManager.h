@@ -0,0 +1,52 @@
+#ifndef MENTORA_CONNECTION_MANAGER_H
+#define MENTORA_CONNECTION_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+enum ConnectionState {
+    CONN_IDLE,
+    CONN_CONNECTING,
+    CONN_CONNECTED,
+    CONN_BACKOFF
+};
+
+// Non-blocking Wi-Fi state machine: call update() every loop.
+// Failed or lost connections retry after an equal-jitter exponential backoff
+// so a classroom of devices does not reconnect in lockstep.
+class ConnectionManager {
+private:
+    const char* ssid;
+    const char* password;
+    ConnectionState state;
+    unsigned long stateSince;
+    unsigned long retryDelay;
+    unsigned int failedAttempts;
+    bool connectedEdge;
+    bool disconnectedEdge;
+
+    const unsigned long CONNECT_TIMEOUT = 15000;
+    const unsigned long BACKOFF_MIN = 1000;
+    const unsigned long BACKOFF_MAX = 60000;
+
+    void startAttempt();
+    void scheduleRetry();
+
+public:
+    ConnectionManager();
+    void begin(const char* networkSsid, const char* networkPassword);
+    void update();
+    bool isConnected();
+    bool justConnected();
+    bool justDisconnected();
+    ConnectionState getState();
+    String getStateName();
+    unsigned long getRetryInMs();
+    unsigned int getFailedAttempts();
+
+    // Exponential backoff capped at maxMs, randomized over the upper half of
+    // each step ("equal jitter": never shorter than half the step)
+    static unsigned long jitteredBackoff(unsigned int failures, unsigned long minMs, unsigned long maxMs);
+};
+
+#endif
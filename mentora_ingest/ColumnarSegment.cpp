@@ -0,0 +1,167 @@
+#include "ColumnarSegment.h"
+
+#include <cstring>
+
+namespace {
+
+const uint8_t SEGMENT_VERSION = 1;
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+void putBytes(std::string& out, std::string_view bytes) {
+    putVarint(out, bytes.size());
+    out.append(bytes.data(), bytes.size());
+}
+
+void putBitmap(std::string& out, const std::vector<uint8_t>& flags) {
+    uint8_t acc = 0;
+    for (size_t i = 0; i < flags.size(); i++) {
+        if (flags[i]) acc |= static_cast<uint8_t>(1u << (i & 7));
+        if ((i & 7) == 7) { out.push_back(static_cast<char>(acc)); acc = 0; }
+    }
+    if (flags.size() & 7) out.push_back(static_cast<char>(acc));
+}
+
+void putXorDouble(std::string& out, uint64_t bits, uint64_t previous) {
+    uint64_t x = bits ^ previous;
+    if (x == 0) { out.push_back(0); return; }
+    int leading = __builtin_clzll(x) / 8;
+    int trailing = __builtin_ctzll(x) / 8;
+    int width = 8 - leading - trailing;
+    out.push_back(static_cast<char>((leading << 4) | width));
+    for (int i = width - 1; i >= 0; i--) {
+        out.push_back(static_cast<char>(x >> (8 * (trailing + i))));
+    }
+}
+
+} // namespace
+
+ColumnarSegment::ColumnarSegment() {
+    keyScratch.reserve(64);
+}
+
+ColumnarSegment::Column& ColumnarSegment::columnFor(const JsonPath& path) {
+    keyScratch.clear();
+    for (int i = 0; i < path.depth; i++) {
+        if (i) keyScratch.push_back('.');
+        keyScratch.append(path.keys[i].data(), path.keys[i].size());
+    }
+    auto it = columnIndex.find(keyScratch);
+    if (it != columnIndex.end()) return columns[it->second];
+
+    // Column first seen mid-segment: earlier rows read back as null
+    columnIndex.emplace(keyScratch, columns.size());
+    columns.emplace_back();
+    Column& column = columns.back();
+    column.name = keyScratch;
+    column.type = JsonType::Null;
+    column.present.assign(receivedAt.size() - 1, 0);
+    return column;
+}
+
+void ColumnarSegment::appendNull(Column& column) {
+    column.present.push_back(0);
+}
+
+void ColumnarSegment::beginRow(int64_t receivedAtMs) {
+    receivedAt.push_back(receivedAtMs);
+}
+
+void ColumnarSegment::addField(const JsonPath& path, const JsonValue& value) {
+    Column& column = columnFor(path);
+    // Duplicate key within a row: first occurrence wins
+    if (column.present.size() == receivedAt.size()) return;
+
+    if (value.type == JsonType::Null) { appendNull(column); return; }
+    if (column.type == JsonType::Null) column.type = value.type;
+    if (column.type != value.type) { appendNull(column); return; }
+
+    column.present.push_back(1);
+    switch (value.type) {
+        case JsonType::Number:
+            column.numbers.push_back(value.number);
+            break;
+        case JsonType::Bool:
+            column.bools.push_back(value.boolean ? 1 : 0);
+            break;
+        case JsonType::String: {
+            auto it = column.dictionary.find(value.text);
+            if (it == column.dictionary.end()) {
+                uint32_t id = static_cast<uint32_t>(column.dictionaryOrder.size());
+                it = column.dictionary.emplace(std::string(value.text), id).first;
+                column.dictionaryOrder.push_back(&it->first);
+            }
+            column.stringIds.push_back(it->second);
+            break;
+        }
+        case JsonType::Null:
+            break;
+    }
+}
+
+void ColumnarSegment::endRow() {
+    for (Column& column : columns) {
+        if (column.present.size() < receivedAt.size()) appendNull(column);
+    }
+}
+
+size_t ColumnarSegment::rowCount() const { return receivedAt.size(); }
+
+int64_t ColumnarSegment::firstReceivedAt() const { return receivedAt.empty() ? 0 : receivedAt.front(); }
+
+void ColumnarSegment::encode(std::string& out) const {
+    out.append("MSEG", 4);
+    out.push_back(static_cast<char>(SEGMENT_VERSION));
+    putVarint(out, receivedAt.size());
+    putVarint(out, columns.size());
+
+    int64_t previous = 0, previousDelta = 0;
+    for (size_t i = 0; i < receivedAt.size(); i++) {
+        if (i == 0) {
+            putVarint(out, static_cast<uint64_t>(receivedAt[0]));
+        } else {
+            int64_t delta = receivedAt[i] - previous;
+            putVarint(out, zigzag(delta - previousDelta));
+            previousDelta = delta;
+        }
+        previous = receivedAt[i];
+    }
+
+    for (const Column& column : columns) {
+        putBytes(out, column.name);
+        out.push_back(static_cast<char>(column.type));
+        putBitmap(out, column.present);
+        switch (column.type) {
+            case JsonType::Number: {
+                uint64_t previousBits = 0;
+                for (double v : column.numbers) {
+                    uint64_t bits;
+                    memcpy(&bits, &v, sizeof bits);
+                    putXorDouble(out, bits, previousBits);
+                    previousBits = bits;
+                }
+                break;
+            }
+            case JsonType::Bool:
+                putBitmap(out, column.bools);
+                break;
+            case JsonType::String:
+                putVarint(out, column.dictionaryOrder.size());
+                for (const std::string* entry : column.dictionaryOrder) putBytes(out, *entry);
+                for (uint32_t id : column.stringIds) putVarint(out, id);
+                break;
+            case JsonType::Null:
+                break;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef MENTORA_INGEST_COLUMNAR_SEGMENT_H
+#define MENTORA_INGEST_COLUMNAR_SEGMENT_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "JsonScanner.h"
+
+// In-memory rows for one device, kept column by column until sealed.
+//
+// On-disk layout (.mseg, all integers LEB128 varints unless noted):
+//   "MSEG" u8 version, rowCount, columnCount
+//   receive time column: first ms, then zigzag delta-of-delta per row
+//   per column: name, u8 type, validity bitmap (rowCount bits), values
+//     Number: XOR of each double with the previous one, leading/trailing
+//             zero bytes trimmed behind a one-byte header
+//     Bool:   bitmap over the present rows
+//     String: dictionary (count, entries) then one index per present row
+class ColumnarSegment {
+private:
+    struct Column {
+        std::string name;
+        JsonType type;
+        std::vector<uint8_t> present;
+        std::vector<double> numbers;
+        std::vector<uint8_t> bools;
+        std::vector<uint32_t> stringIds;
+        std::map<std::string, uint32_t, std::less<>> dictionary;
+        std::vector<const std::string*> dictionaryOrder;
+    };
+
+    std::deque<Column> columns;
+    std::unordered_map<std::string, size_t> columnIndex;
+    std::vector<int64_t> receivedAt;
+    std::string keyScratch;
+
+    Column& columnFor(const JsonPath& path);
+    void appendNull(Column& column);
+
+public:
+    ColumnarSegment();
+    ColumnarSegment(ColumnarSegment&&) = default;
+    ColumnarSegment& operator=(ColumnarSegment&&) = default;
+
+    void beginRow(int64_t receivedAtMs);
+    void addField(const JsonPath& path, const JsonValue& value);
+    void endRow();
+
+    size_t rowCount() const;
+    int64_t firstReceivedAt() const;
+    void encode(std::string& out) const;
+};
+
+#endif
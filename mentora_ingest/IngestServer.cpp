@@ -0,0 +1,435 @@
+#include "IngestServer.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <functional>
+#include <mutex>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+const size_t MAX_HEADER_BYTES = 8192;
+const size_t READ_CHUNK = 16384;
+const int MAX_EVENTS = 256;
+const int EPOLL_TIMEOUT_MS = 200;
+const int64_t SEAL_CHECK_MS = 250;
+
+int64_t wallClockMs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+bool equalsIgnoreCase(std::string_view a, const char* b) {
+    size_t n = strlen(b);
+    if (a.size() != n) return false;
+    for (size_t i = 0; i < n; i++) {
+        char c = a[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != b[i]) return false;
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+std::string_view queryParam(std::string_view query, std::string_view name) {
+    while (!query.empty()) {
+        size_t amp = query.find('&');
+        std::string_view pair = query.substr(0, amp);
+        size_t eq = pair.find('=');
+        if (eq != std::string_view::npos && pair.substr(0, eq) == name) return pair.substr(eq + 1);
+        if (amp == std::string_view::npos) break;
+        query.remove_prefix(amp + 1);
+    }
+    return {};
+}
+
+int openListener(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof one);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+class IngestServer::Worker {
+private:
+    struct Connection {
+        int fd;
+        std::string peer;
+        std::string in;
+        size_t consumed;
+        std::string out;
+        size_t written;
+        bool closeAfterWrite;
+        bool readPaused;   // input left unread until responses drain
+    };
+
+    // A validated body accepted by another worker for a device this one owns
+    struct Handoff {
+        std::string device;
+        std::string body;
+        int rows;
+        int64_t receivedAt;
+    };
+
+    const ServerConfig& config;
+    const std::atomic<bool>& running;
+    const std::vector<std::unique_ptr<Worker>>& peers;
+    size_t id;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    TelemetryStore store;
+    std::unordered_map<int, Connection> connections;
+    std::string deviceScratch;
+
+    std::mutex inboxLock;
+    std::vector<Handoff> inbox;
+    std::vector<Handoff> draining;
+
+public:
+    std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> rows;
+    std::atomic<uint64_t> rejected;
+
+    Worker(const ServerConfig& c, const std::atomic<bool>& r, const std::vector<std::unique_ptr<Worker>>& p, SegmentWriter* writer, int workerId)
+        : config(c), running(r), peers(p), id(static_cast<size_t>(workerId)), listenFd(-1), epollFd(-1), wakeFd(-1),
+          store(writer, c.limits, workerId), requests(0), rows(0), rejected(0) {}
+
+    ~Worker() {
+        for (auto& entry : connections) close(entry.first);
+        if (listenFd >= 0) close(listenFd);
+        if (wakeFd >= 0) close(wakeFd);
+        if (epollFd >= 0) close(epollFd);
+    }
+
+    bool begin() {
+        listenFd = openListener(config.port);
+        if (listenFd < 0) { perror("listen"); return false; }
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) { perror("epoll_create1"); return false; }
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) { perror("eventfd"); return false; }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) != 0) return false;
+        ev.data.fd = wakeFd;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) == 0;
+    }
+
+    // Called from other workers' threads
+    void handOff(const std::string& device, std::string_view body, int rowCount, int64_t receivedAt) {
+        bool wasEmpty;
+        {
+            std::lock_guard<std::mutex> guard(inboxLock);
+            wasEmpty = inbox.empty();
+            inbox.push_back(Handoff{device, std::string(body), rowCount, receivedAt});
+        }
+        if (wasEmpty) {
+            uint64_t one = 1;
+            ssize_t ignored = write(wakeFd, &one, sizeof one);
+            (void)ignored;
+        }
+    }
+
+    // Runs on the server thread once every worker loop has exited
+    void finish() {
+        drainInbox();
+        store.sealAll();
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        int64_t lastSealCheck = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            int n = epoll_wait(epollFd, events, MAX_EVENTS, EPOLL_TIMEOUT_MS);
+            for (int i = 0; i < n; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) { acceptAll(); continue; }
+                if (fd == wakeFd) { drainInbox(); continue; }
+                auto it = connections.find(fd);
+                if (it == connections.end()) continue;
+                Connection& conn = it->second;
+                bool alive = true;
+                if (events[i].events & (EPOLLHUP | EPOLLERR)) alive = false;
+                if (alive && (events[i].events & EPOLLIN)) alive = readAndServe(conn);
+                if (alive && (events[i].events & EPOLLOUT)) {
+                    alive = flush(conn);
+                    if (alive && conn.readPaused && conn.out.empty()) alive = readAndServe(conn);
+                }
+                if (!alive) closeConnection(fd);
+            }
+            int64_t now = wallClockMs();
+            if (now - lastSealCheck >= SEAL_CHECK_MS) {
+                store.sealExpired(now);
+                lastSealCheck = now;
+            }
+        }
+    }
+
+private:
+    void drainInbox() {
+        uint64_t count;
+        ssize_t ignored = read(wakeFd, &count, sizeof count);
+        (void)ignored;
+        {
+            std::lock_guard<std::mutex> guard(inboxLock);
+            draining.swap(inbox);
+        }
+        for (const Handoff& h : draining) store.append(h.device, h.body, h.rows, h.receivedAt);
+        draining.clear();
+    }
+
+    // Devices post on a fresh connection each time, so whichever listener
+    // accepted the request, its rows go to the one worker that owns the device
+    void route(std::string_view deviceId, std::string_view body, int rowCount) {
+        TelemetryStore::sanitizeDeviceId(deviceId, deviceScratch);
+        size_t owner = std::hash<std::string>()(deviceScratch) % peers.size();
+        if (owner == id) store.append(deviceScratch, body, rowCount, wallClockMs());
+        else peers[owner]->handOff(deviceScratch, body, rowCount, wallClockMs());
+    }
+
+    void acceptAll() {
+        for (;;) {
+            sockaddr_in addr{};
+            socklen_t len = sizeof addr;
+            int fd = accept4(listenFd, reinterpret_cast<sockaddr*>(&addr), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+            char ip[INET_ADDRSTRLEN] = "";
+            inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof ip);
+
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            ev.data.fd = fd;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) { close(fd); continue; }
+            connections[fd] = Connection{fd, ip, std::string(), 0, std::string(), 0, false, false};
+        }
+    }
+
+    void closeConnection(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    }
+
+    bool readAndServe(Connection& conn) {
+        // One full request is the most a connection may hold unanswered
+        size_t cap = MAX_HEADER_BYTES + config.maxBodyBytes;
+        bool peerClosed = false;
+        conn.readPaused = false;
+        while (!conn.closeAfterWrite) {
+            size_t buffered = conn.in.size() - conn.consumed;
+            if (buffered >= cap) {
+                // Pipelined requests: answer what is complete to make room
+                serveBuffered(conn);
+                if (conn.closeAfterWrite) break;
+                if (conn.in.size() - conn.consumed >= cap) {
+                    respond(conn, 413, "{\"error\":\"payload too large\"}", true);
+                    break;
+                }
+                if (!flush(conn)) return false;
+                // A client that does not read its responses gets no more input read
+                if (!conn.out.empty()) { conn.readPaused = true; return true; }
+                continue;
+            }
+            size_t used = conn.in.size();
+            size_t want = std::min(READ_CHUNK, cap - buffered);
+            conn.in.resize(used + want);
+            ssize_t n = read(conn.fd, &conn.in[used], want);
+            conn.in.resize(used + (n > 0 ? static_cast<size_t>(n) : 0));
+            if (n > 0) continue;
+            if (n == 0) { peerClosed = true; break; }
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        serveBuffered(conn);
+        if (!flush(conn)) return false;
+        return !peerClosed || !conn.out.empty();
+    }
+
+    // Answers every complete request in the buffer; bodies are parsed in place
+    void serveBuffered(Connection& conn) {
+        while (!conn.closeAfterWrite) {
+            std::string_view pending(conn.in.data() + conn.consumed, conn.in.size() - conn.consumed);
+            size_t headerEnd = pending.find("\r\n\r\n");
+            if (headerEnd == std::string_view::npos) {
+                if (pending.size() > MAX_HEADER_BYTES) respond(conn, 431, "{\"error\":\"headers too large\"}", true);
+                break;
+            }
+            std::string_view head = pending.substr(0, headerEnd);
+            size_t lineEnd = head.find("\r\n");
+            std::string_view requestLine = head.substr(0, lineEnd);
+            size_t sp1 = requestLine.find(' ');
+            size_t sp2 = requestLine.rfind(' ');
+            if (sp1 == std::string_view::npos || sp2 <= sp1) { respond(conn, 400, "{\"error\":\"bad request\"}", true); break; }
+            std::string_view method = requestLine.substr(0, sp1);
+            std::string_view target = requestLine.substr(sp1 + 1, sp2 - sp1 - 1);
+            bool keepAlive = requestLine.substr(sp2 + 1) == "HTTP/1.1";
+
+            size_t contentLength = 0;
+            std::string_view deviceId;
+            std::string_view headers = lineEnd == std::string_view::npos ? std::string_view() : head.substr(lineEnd + 2);
+            while (!headers.empty()) {
+                size_t eol = headers.find("\r\n");
+                std::string_view line = headers.substr(0, eol);
+                size_t colon = line.find(':');
+                if (colon != std::string_view::npos) {
+                    std::string_view name = line.substr(0, colon);
+                    std::string_view value = trim(line.substr(colon + 1));
+                    if (equalsIgnoreCase(name, "content-length")) contentLength = strtoul(std::string(value).c_str(), nullptr, 10);
+                    else if (equalsIgnoreCase(name, "x-device-id")) deviceId = value;
+                    else if (equalsIgnoreCase(name, "connection")) keepAlive = !equalsIgnoreCase(value, "close");
+                }
+                if (eol == std::string_view::npos) break;
+                headers.remove_prefix(eol + 2);
+            }
+            if (contentLength > config.maxBodyBytes) { respond(conn, 413, "{\"error\":\"payload too large\"}", true); break; }
+            size_t total = headerEnd + 4 + contentLength;
+            if (pending.size() < total) break;
+
+            std::string_view body = pending.substr(headerEnd + 4, contentLength);
+            size_t q = target.find('?');
+            std::string_view path = target.substr(0, q);
+            std::string_view query = q == std::string_view::npos ? std::string_view() : target.substr(q + 1);
+            if (deviceId.empty()) deviceId = queryParam(query, "device");
+            if (deviceId.empty()) deviceId = conn.peer;
+
+            requests.fetch_add(1, std::memory_order_relaxed);
+            if (method == "POST" && path == "/api/mentora") {
+                int stored = TelemetryStore::validate(body);
+                if (stored < 0) {
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                    respond(conn, 400, "{\"error\":\"Bad JSON\"}", !keepAlive);
+                } else {
+                    if (stored > 0) route(deviceId, body, stored);
+                    rows.fetch_add(static_cast<uint64_t>(stored), std::memory_order_relaxed);
+                    respond(conn, 200, "{\"ok\":true}", !keepAlive);
+                }
+            } else {
+                respond(conn, 404, "{\"error\":\"not found\"}", !keepAlive);
+            }
+            conn.consumed += total;
+        }
+        if (conn.consumed == conn.in.size()) {
+            conn.in.clear();
+            conn.consumed = 0;
+        } else if (conn.consumed > conn.in.size() / 2) {
+            conn.in.erase(0, conn.consumed);
+            conn.consumed = 0;
+        }
+    }
+
+    void respond(Connection& conn, int status, const char* body, bool closeAfter) {
+        const char* reason = "OK";
+        switch (status) {
+            case 400: reason = "Bad Request"; break;
+            case 404: reason = "Not Found"; break;
+            case 413: reason = "Payload Too Large"; break;
+            case 431: reason = "Request Header Fields Too Large"; break;
+        }
+        char head[160];
+        int n = snprintf(head, sizeof head, "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n%s\r\n",
+                         status, reason, strlen(body), closeAfter ? "Connection: close\r\n" : "");
+        conn.out.append(head, static_cast<size_t>(n));
+        conn.out.append(body);
+        if (closeAfter) conn.closeAfterWrite = true;
+    }
+
+    bool flush(Connection& conn) {
+        while (conn.written < conn.out.size()) {
+            ssize_t n = send(conn.fd, conn.out.data() + conn.written, conn.out.size() - conn.written, MSG_NOSIGNAL);
+            if (n > 0) { conn.written += static_cast<size_t>(n); continue; }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            return false;
+        }
+        conn.out.clear();
+        conn.written = 0;
+        return !conn.closeAfterWrite;
+    }
+};
+
+IngestServer::IngestServer(const ServerConfig& c) : config(c), writer(c.dataDir), running(false) {}
+
+IngestServer::~IngestServer() {
+    stop();
+    for (std::thread& t : threads) if (t.joinable()) t.join();
+}
+
+bool IngestServer::begin() {
+    if (!writer.begin()) return false;
+    for (int i = 0; i < config.workers; i++) {
+        workers.emplace_back(new Worker(config, running, workers, &writer, i));
+        if (!workers.back()->begin()) return false;
+    }
+    return true;
+}
+
+void IngestServer::run(unsigned long statsIntervalMs) {
+    running = true;
+    for (auto& worker : workers) threads.emplace_back(&Worker::run, worker.get());
+
+    uint64_t lastRows = 0;
+    int64_t lastReport = wallClockMs();
+    while (running.load()) {
+        usleep(100 * 1000);
+        int64_t now = wallClockMs();
+        if (now - lastReport < static_cast<int64_t>(statsIntervalMs)) continue;
+        uint64_t totalRequests = 0, totalRows = 0, totalRejected = 0;
+        for (auto& worker : workers) {
+            totalRequests += worker->requests.load();
+            totalRows += worker->rows.load();
+            totalRejected += worker->rejected.load();
+        }
+        printf("[ingest] %.0f rows/s, %llu requests, %llu rejected, %llu segments, %llu bytes on disk\n",
+               (totalRows - lastRows) * 1000.0 / (now - lastReport),
+               static_cast<unsigned long long>(totalRequests), static_cast<unsigned long long>(totalRejected),
+               static_cast<unsigned long long>(writer.getSegmentsWritten()), static_cast<unsigned long long>(writer.getBytesWritten()));
+        fflush(stdout);
+        lastRows = totalRows;
+        lastReport = now;
+    }
+
+    for (std::thread& t : threads) t.join();
+    threads.clear();
+    // Loops have stopped, so no more handoffs can arrive: flush and seal
+    for (auto& worker : workers) worker->finish();
+    writer.stop();
+    if (writer.getWriteErrors() > 0) {
+        fprintf(stderr, "[ingest] %llu segment writes failed\n", static_cast<unsigned long long>(writer.getWriteErrors()));
+    }
+}
+
+void IngestServer::stop() { running = false; }
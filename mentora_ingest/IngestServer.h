@@ -0,0 +1,45 @@
+#ifndef MENTORA_INGEST_INGEST_SERVER_H
+#define MENTORA_INGEST_INGEST_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SegmentWriter.h"
+#include "TelemetryStore.h"
+
+struct ServerConfig {
+    uint16_t port;
+    int workers;
+    size_t maxBodyBytes;
+    std::string dataDir;
+    StoreLimits limits;
+};
+
+// HTTP/1.1 keep-alive endpoint for the firmware's postUrl (POST /api/mentora).
+// Each worker owns a SO_REUSEPORT listener, an edge-triggered epoll loop and
+// its own TelemetryStore. Devices are hashed to one owning worker; a request
+// accepted elsewhere is parsed there and its body handed to the owner.
+class IngestServer {
+private:
+    class Worker;
+
+    ServerConfig config;
+    SegmentWriter writer;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<bool> running;
+
+public:
+    explicit IngestServer(const ServerConfig& c);
+    ~IngestServer();
+    bool begin();
+    // Blocks until stop(); prints throughput every statsIntervalMs
+    void run(unsigned long statsIntervalMs);
+    // Safe to call from a signal handler
+    void stop();
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "JsonScanner.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+const char* skipDigits(const char* p, const char* end) {
+    while (p < end && isDigit(*p)) p++;
+    return p;
+}
+
+// End of the RFC 8259 number at p, or nullptr. from_chars alone would also
+// take "inf", "nan" and leading zeros, which stored segments cannot print back.
+const char* matchNumber(const char* p, const char* end) {
+    if (p < end && *p == '-') p++;
+    if (p >= end || !isDigit(*p)) return nullptr;
+    p = *p == '0' ? p + 1 : skipDigits(p, end);
+    if (p < end && *p == '.') {
+        if (++p >= end || !isDigit(*p)) return nullptr;
+        p = skipDigits(p, end);
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        if (++p < end && (*p == '+' || *p == '-')) p++;
+        if (p >= end || !isDigit(*p)) return nullptr;
+        p = skipDigits(p, end);
+    }
+    return p;
+}
+
+} // namespace
+
+JsonScanner::JsonScanner(const char* data, size_t length) : cur(data), end(data + length), path{} {}
+
+void JsonScanner::skipWhitespace() {
+    while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\r' || *cur == '\n')) cur++;
+}
+
+bool JsonScanner::consume(char c) {
+    skipWhitespace();
+    if (cur < end && *cur == c) { cur++; return true; }
+    return false;
+}
+
+bool JsonScanner::scanString(std::string_view& out) {
+    skipWhitespace();
+    if (cur >= end || *cur != '"') return false;
+    const char* start = ++cur;
+    while (cur < end) {
+        const char* quote = static_cast<const char*>(memchr(cur, '"', end - cur));
+        if (!quote) return false;
+        // A quote is escaped only if preceded by an odd run of backslashes
+        const char* back = quote;
+        while (back > start && back[-1] == '\\') back--;
+        cur = quote + 1;
+        if (((quote - back) & 1) == 0) {
+            out = std::string_view(start, quote - start);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JsonScanner::scanScalar(JsonValue& out) {
+    skipWhitespace();
+    if (cur >= end) return false;
+    out = JsonValue{JsonType::Null, false, 0, {}};
+    switch (*cur) {
+        case '"':
+            out.type = JsonType::String;
+            return scanString(out.text);
+        case 't':
+            if (end - cur < 4 || memcmp(cur, "true", 4) != 0) return false;
+            cur += 4; out.type = JsonType::Bool; out.boolean = true;
+            return true;
+        case 'f':
+            if (end - cur < 5 || memcmp(cur, "false", 5) != 0) return false;
+            cur += 5; out.type = JsonType::Bool; out.boolean = false;
+            return true;
+        case 'n':
+            if (end - cur < 4 || memcmp(cur, "null", 4) != 0) return false;
+            cur += 4;
+            return true;
+        default: {
+            const char* numberEnd = matchNumber(cur, end);
+            if (!numberEnd) return false;
+            // Out-of-range exponents fail here rather than storing infinity
+            std::from_chars_result r = std::from_chars(cur, numberEnd, out.number);
+            if (r.ec != std::errc() || r.ptr != numberEnd) return false;
+            cur = r.ptr; out.type = JsonType::Number;
+            return true;
+        }
+    }
+}
+
+bool JsonScanner::skipArray() {
+    // Arrays are not part of the telemetry schema; skip them balanced
+    int nesting = 0;
+    while (cur < end) {
+        char c = *cur;
+        if (c == '"') {
+            std::string_view ignored;
+            if (!scanString(ignored)) return false;
+            continue;
+        }
+        cur++;
+        if (c == '[' || c == '{') nesting++;
+        else if ((c == ']' || c == '}') && --nesting == 0) return true;
+    }
+    return false;
+}
+
+bool JsonScanner::scanValue(JsonFieldVisitor& visitor) {
+    skipWhitespace();
+    if (cur >= end) return false;
+    if (*cur == '{') return scanObject(visitor);
+    if (*cur == '[') return skipArray();
+    JsonValue value;
+    if (!scanScalar(value)) return false;
+    visitor.field(path, value);
+    return true;
+}
+
+bool JsonScanner::scanObject(JsonFieldVisitor& visitor) {
+    if (!consume('{')) return false;
+    if (consume('}')) return true;
+    if (path.depth >= JsonPath::MAX_DEPTH) return false;
+    do {
+        std::string_view key;
+        if (!scanString(key) || !consume(':')) return false;
+        path.keys[path.depth++] = key;
+        bool ok = scanValue(visitor);
+        path.depth--;
+        if (!ok) return false;
+    } while (consume(','));
+    return consume('}');
+}
+
+int JsonScanner::scan(JsonFieldVisitor& visitor) {
+    int rows = 0;
+    path.depth = 0;
+    skipWhitespace();
+    if (consume('[')) {
+        if (!consume(']')) {
+            do {
+                visitor.beginRow();
+                if (!scanObject(visitor)) return -1;
+                visitor.endRow();
+                rows++;
+            } while (consume(','));
+            if (!consume(']')) return -1;
+        }
+    } else {
+        visitor.beginRow();
+        if (!scanObject(visitor)) return -1;
+        visitor.endRow();
+        rows = 1;
+    }
+    skipWhitespace();
+    return cur == end ? rows : -1;
+}
@@ -0,0 +1,55 @@
+#ifndef MENTORA_INGEST_JSON_SCANNER_H
+#define MENTORA_INGEST_JSON_SCANNER_H
+
+#include <cstddef>
+#include <string_view>
+
+// Flattens the SensorFusion::getJSONData() payload without building a DOM.
+// Keys and string values are views into the request buffer; strings keep
+// their JSON escapes since they are stored verbatim.
+
+enum class JsonType { Null, Bool, Number, String };
+
+struct JsonValue {
+    JsonType type;
+    bool boolean;
+    double number;
+    std::string_view text;
+};
+
+struct JsonPath {
+    static const int MAX_DEPTH = 4;
+    std::string_view keys[MAX_DEPTH];
+    int depth;
+};
+
+class JsonFieldVisitor {
+public:
+    virtual ~JsonFieldVisitor() {}
+    virtual void beginRow() = 0;
+    virtual void field(const JsonPath& path, const JsonValue& value) = 0;
+    virtual void endRow() = 0;
+};
+
+class JsonScanner {
+private:
+    const char* cur;
+    const char* end;
+    JsonPath path;
+
+    void skipWhitespace();
+    bool consume(char c);
+    bool scanString(std::string_view& out);
+    bool scanScalar(JsonValue& out);
+    bool scanObject(JsonFieldVisitor& visitor);
+    bool scanValue(JsonFieldVisitor& visitor);
+    bool skipArray();
+
+public:
+    JsonScanner(const char* data, size_t length);
+    // Accepts a single object (one row) or an array of objects (a batch).
+    // Returns the number of rows delivered, or -1 on malformed input.
+    int scan(JsonFieldVisitor& visitor);
+};
+
+#endif
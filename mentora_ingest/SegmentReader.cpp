@@ -0,0 +1,146 @@
+#include "SegmentReader.h"
+
+#include <cstring>
+
+namespace {
+
+const uint8_t SEGMENT_VERSION = 1;
+
+int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+} // namespace
+
+SegmentReader::SegmentReader(const char* data, size_t length)
+    : cur(reinterpret_cast<const uint8_t*>(data)), end(reinterpret_cast<const uint8_t*>(data) + length) {}
+
+bool SegmentReader::getByte(uint8_t& out) {
+    if (cur >= end) return false;
+    out = *cur++;
+    return true;
+}
+
+bool SegmentReader::getVarint(uint64_t& out) {
+    out = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t b;
+        if (!getByte(b)) return false;
+        out |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+bool SegmentReader::getBytes(std::string& out) {
+    uint64_t length;
+    if (!getVarint(length) || length > static_cast<uint64_t>(end - cur)) return false;
+    out.assign(reinterpret_cast<const char*>(cur), length);
+    cur += length;
+    return true;
+}
+
+bool SegmentReader::getBitmap(size_t count, std::vector<uint8_t>& out) {
+    size_t bytes = (count + 7) / 8;
+    if (bytes > static_cast<size_t>(end - cur)) return false;
+    out.resize(count);
+    for (size_t i = 0; i < count; i++) out[i] = (cur[i >> 3] >> (i & 7)) & 1;
+    cur += bytes;
+    return true;
+}
+
+bool SegmentReader::getXorDouble(uint64_t previous, uint64_t& bits) {
+    uint8_t header;
+    if (!getByte(header)) return false;
+    if (header == 0) { bits = previous; return true; }
+    int leading = header >> 4;
+    int width = header & 0x0F;
+    int trailing = 8 - leading - width;
+    if (width == 0 || trailing < 0 || width > end - cur) return false;
+    uint64_t x = 0;
+    for (int i = 0; i < width; i++) x = (x << 8) | *cur++;
+    bits = previous ^ (x << (8 * trailing));
+    return true;
+}
+
+bool SegmentReader::read(DecodedSegment& out) {
+    out = DecodedSegment();
+    uint8_t version;
+    if (end - cur < 4 || memcmp(cur, "MSEG", 4) != 0) return false;
+    cur += 4;
+    if (!getByte(version) || version != SEGMENT_VERSION) return false;
+
+    uint64_t rows, columnCount;
+    if (!getVarint(rows) || !getVarint(columnCount)) return false;
+    // Every row and column costs at least one encoded byte
+    if (rows > static_cast<uint64_t>(end - cur) || columnCount > static_cast<uint64_t>(end - cur)) return false;
+
+    int64_t previous = 0, previousDelta = 0;
+    for (uint64_t i = 0; i < rows; i++) {
+        uint64_t v;
+        if (!getVarint(v)) return false;
+        if (i == 0) {
+            previous = static_cast<int64_t>(v);
+        } else {
+            previousDelta += unzigzag(v);
+            previous += previousDelta;
+        }
+        out.receivedAt.push_back(previous);
+    }
+
+    for (uint64_t c = 0; c < columnCount; c++) {
+        SegmentColumn column;
+        uint8_t type;
+        std::vector<uint8_t> present;
+        if (!getBytes(column.name) || !getByte(type) || type > static_cast<uint8_t>(JsonType::String)) return false;
+        if (!getBitmap(rows, present)) return false;
+        column.type = static_cast<JsonType>(type);
+        column.cells.assign(rows, SegmentCell{false, false, 0, std::string()});
+
+        size_t presentCount = 0;
+        for (uint8_t p : present) presentCount += p;
+        if (column.type == JsonType::Null && presentCount > 0) return false;
+
+        switch (column.type) {
+            case JsonType::Number: {
+                uint64_t bits = 0;
+                for (uint64_t r = 0; r < rows; r++) {
+                    if (!present[r]) continue;
+                    if (!getXorDouble(bits, bits)) return false;
+                    memcpy(&column.cells[r].number, &bits, sizeof bits);
+                    column.cells[r].present = true;
+                }
+                break;
+            }
+            case JsonType::Bool: {
+                std::vector<uint8_t> values;
+                if (!getBitmap(presentCount, values)) return false;
+                size_t next = 0;
+                for (uint64_t r = 0; r < rows; r++) {
+                    if (!present[r]) continue;
+                    column.cells[r].boolean = values[next++] != 0;
+                    column.cells[r].present = true;
+                }
+                break;
+            }
+            case JsonType::String: {
+                uint64_t entries;
+                if (!getVarint(entries) || entries > static_cast<uint64_t>(end - cur)) return false;
+                std::vector<std::string> dictionary(entries);
+                for (std::string& entry : dictionary) if (!getBytes(entry)) return false;
+                for (uint64_t r = 0; r < rows; r++) {
+                    if (!present[r]) continue;
+                    uint64_t id;
+                    if (!getVarint(id) || id >= entries) return false;
+                    column.cells[r].text = dictionary[id];
+                    column.cells[r].present = true;
+                }
+                break;
+            }
+            case JsonType::Null:
+                break;
+        }
+        out.columns.push_back(std::move(column));
+    }
+    return cur == end;
+}
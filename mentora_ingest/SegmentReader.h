@@ -0,0 +1,46 @@
+#ifndef MENTORA_INGEST_SEGMENT_READER_H
+#define MENTORA_INGEST_SEGMENT_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "JsonScanner.h"
+
+struct SegmentCell {
+    bool present;
+    bool boolean;
+    double number;
+    std::string text;
+};
+
+struct SegmentColumn {
+    std::string name;
+    JsonType type;
+    std::vector<SegmentCell> cells; // one per row
+};
+
+struct DecodedSegment {
+    std::vector<int64_t> receivedAt;
+    std::vector<SegmentColumn> columns;
+};
+
+// Decodes the .mseg layout written by ColumnarSegment::encode()
+class SegmentReader {
+private:
+    const uint8_t* cur;
+    const uint8_t* end;
+
+    bool getByte(uint8_t& out);
+    bool getVarint(uint64_t& out);
+    bool getBytes(std::string& out);
+    bool getBitmap(size_t count, std::vector<uint8_t>& out);
+    bool getXorDouble(uint64_t previous, uint64_t& bits);
+
+public:
+    SegmentReader(const char* data, size_t length);
+    // Returns false on truncated or malformed input
+    bool read(DecodedSegment& out);
+};
+
+#endif
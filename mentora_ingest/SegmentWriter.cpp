@@ -0,0 +1,144 @@
+#include "SegmentWriter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t MAX_BATCH = 256;
+
+bool ensureDirectory(const std::string& path) {
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+} // namespace
+
+SegmentWriter::SegmentWriter(const std::string& directory)
+    : dataDir(directory), dataDirFd(-1), stopping(false), segmentsWritten(0), bytesWritten(0), writeErrors(0) {}
+
+SegmentWriter::~SegmentWriter() {
+    stop();
+    if (dataDirFd >= 0) close(dataDirFd);
+}
+
+bool SegmentWriter::begin() {
+    if (!ensureDirectory(dataDir)) {
+        perror(("mkdir " + dataDir).c_str());
+        return false;
+    }
+    dataDirFd = open(dataDir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dataDirFd < 0) {
+        perror(("open " + dataDir).c_str());
+        return false;
+    }
+    worker = std::thread(&SegmentWriter::run, this);
+    return true;
+}
+
+void SegmentWriter::submit(const std::string& device, const std::string& tag, ColumnarSegment&& segment) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        queue.push_back(Job{device, tag, std::move(segment)});
+    }
+    wake.notify_one();
+}
+
+void SegmentWriter::stop() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+void SegmentWriter::run() {
+    std::string buffer;
+    std::vector<Job> batch;
+    std::vector<Staged> staged;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            while (!queue.empty() && batch.size() < MAX_BATCH) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        for (const Job& job : batch) {
+            Staged file;
+            if (stageSegment(job, buffer, file)) staged.push_back(std::move(file));
+            else writeErrors++;
+        }
+        publish(staged);
+        batch.clear();
+        staged.clear();
+    }
+}
+
+bool SegmentWriter::stageSegment(const Job& job, std::string& buffer, Staged& file) {
+    std::string dir = dataDir + "/" + job.device;
+    if (!ensureDirectory(dir)) return false;
+
+    buffer.clear();
+    job.segment.encode(buffer);
+
+    file.name = dir + "/" + std::to_string(job.segment.firstReceivedAt()) + "-" + job.tag + ".mseg";
+    file.temp = file.name + ".tmp";
+    file.bytes = buffer.size();
+    int fd = open(file.temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    const char* p = buffer.data();
+    size_t left = buffer.size();
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            unlink(file.temp.c_str());
+            return false;
+        }
+        p += n; left -= static_cast<size_t>(n);
+    }
+    close(fd);
+    return true;
+}
+
+void SegmentWriter::publish(std::vector<Staged>& staged) {
+    if (staged.empty()) return;
+    // One syncfs per batch instead of an fsync per file and directory. The
+    // data must be durable before the renames publish it, or a crash can
+    // leave an empty or truncated .mseg under the final name.
+    if (syncfs(dataDirFd) != 0) {
+        for (const Staged& file : staged) unlink(file.temp.c_str());
+        writeErrors += staged.size();
+        return;
+    }
+    size_t renamed = 0;
+    uint64_t bytes = 0;
+    for (const Staged& file : staged) {
+        if (rename(file.temp.c_str(), file.name.c_str()) == 0) {
+            renamed++;
+            bytes += file.bytes;
+        } else {
+            unlink(file.temp.c_str());
+            writeErrors++;
+        }
+    }
+    // Second sync makes every new directory entry durable
+    if (syncfs(dataDirFd) != 0) {
+        writeErrors += renamed;
+        return;
+    }
+    segmentsWritten += renamed;
+    bytesWritten += bytes;
+}
+
+uint64_t SegmentWriter::getSegmentsWritten() const { return segmentsWritten.load(); }
+uint64_t SegmentWriter::getBytesWritten() const { return bytesWritten.load(); }
+uint64_t SegmentWriter::getWriteErrors() const { return writeErrors.load(); }
@@ -0,0 +1,58 @@
+#ifndef MENTORA_INGEST_SEGMENT_WRITER_H
+#define MENTORA_INGEST_SEGMENT_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ColumnarSegment.h"
+
+// Encodes sealed segments and writes them to disk off the event loop.
+// Files land as <dataDir>/<device>/<firstMs>-<tag>.mseg via a temp + rename;
+// each drained batch of segments shares one pair of filesystem syncs.
+class SegmentWriter {
+private:
+    struct Job {
+        std::string device;
+        std::string tag;
+        ColumnarSegment segment;
+    };
+
+    struct Staged {
+        std::string temp;
+        std::string name;
+        size_t bytes;
+    };
+
+    std::string dataDir;
+    int dataDirFd;
+    std::deque<Job> queue;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::thread worker;
+    bool stopping;
+    std::atomic<uint64_t> segmentsWritten;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> writeErrors;
+
+    void run();
+    bool stageSegment(const Job& job, std::string& buffer, Staged& file);
+    void publish(std::vector<Staged>& staged);
+
+public:
+    explicit SegmentWriter(const std::string& directory);
+    ~SegmentWriter();
+    bool begin();
+    void submit(const std::string& device, const std::string& tag, ColumnarSegment&& segment);
+    // Drains the queue and joins the writer thread
+    void stop();
+
+    uint64_t getSegmentsWritten() const;
+    uint64_t getBytesWritten() const;
+    uint64_t getWriteErrors() const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "TelemetryStore.h"
+
+namespace {
+
+const size_t MAX_DEVICE_ID = 64;
+
+class ValidatingVisitor : public JsonFieldVisitor {
+public:
+    void beginRow() override {}
+    void field(const JsonPath&, const JsonValue&) override {}
+    void endRow() override {}
+};
+
+} // namespace
+
+TelemetryStore::TelemetryStore(SegmentWriter* w, const StoreLimits& l, int workerId)
+    : writer(w), limits(l), tagPrefix("w" + std::to_string(workerId) + "-"), current(nullptr), currentTime(0), rowsAccepted(0) {}
+
+int TelemetryStore::validate(std::string_view body) {
+    // Run before append() so a malformed batch never leaves half its rows behind
+    ValidatingVisitor validator;
+    return JsonScanner(body.data(), body.size()).scan(validator);
+}
+
+void TelemetryStore::sanitizeDeviceId(std::string_view deviceId, std::string& out) {
+    // Device ids become directory names: keep them to a safe alphabet
+    out.clear();
+    for (size_t i = 0; i < deviceId.size() && i < MAX_DEVICE_ID; i++) {
+        char c = deviceId[i];
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        out.push_back(safe ? c : '_');
+    }
+    if (out.empty()) out = "unknown";
+}
+
+void TelemetryStore::append(const std::string& deviceId, std::string_view body, int rows, int64_t nowMs) {
+    auto it = devices.find(deviceId);
+    if (it == devices.end()) {
+        it = devices.emplace(deviceId, DeviceState{ColumnarSegment(), nowMs, 0}).first;
+    }
+    current = &it->second;
+    currentTime = nowMs;
+    JsonScanner(body.data(), body.size()).scan(*this);
+    current = nullptr;
+
+    if (it->second.segment.rowCount() >= limits.rowsPerSegment) seal(it->first, it->second);
+    rowsAccepted += static_cast<uint64_t>(rows);
+}
+
+void TelemetryStore::beginRow() {
+    if (current->segment.rowCount() == 0) current->openedAt = currentTime;
+    current->segment.beginRow(currentTime);
+}
+
+void TelemetryStore::field(const JsonPath& path, const JsonValue& value) { current->segment.addField(path, value); }
+
+void TelemetryStore::endRow() { current->segment.endRow(); }
+
+void TelemetryStore::seal(const std::string& device, DeviceState& state) {
+    if (state.segment.rowCount() == 0) return;
+    writer->submit(device, tagPrefix + std::to_string(state.sequence++), std::move(state.segment));
+    state.segment = ColumnarSegment();
+}
+
+void TelemetryStore::sealExpired(int64_t nowMs) {
+    for (auto& entry : devices) {
+        DeviceState& state = entry.second;
+        if (state.segment.rowCount() > 0 && nowMs - state.openedAt >= limits.maxSegmentAgeMs) seal(entry.first, state);
+    }
+}
+
+void TelemetryStore::sealAll() {
+    for (auto& entry : devices) seal(entry.first, entry.second);
+}
+
+uint64_t TelemetryStore::getRowsAccepted() const { return rowsAccepted; }
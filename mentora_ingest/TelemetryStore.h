@@ -0,0 +1,53 @@
+#ifndef MENTORA_INGEST_TELEMETRY_STORE_H
+#define MENTORA_INGEST_TELEMETRY_STORE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "ColumnarSegment.h"
+#include "JsonScanner.h"
+#include "SegmentWriter.h"
+
+struct StoreLimits {
+    size_t rowsPerSegment;
+    int64_t maxSegmentAgeMs;
+};
+
+// Per-device open segments owned by one event loop; not thread safe.
+// The server routes every device to a single store, so each device has one
+// open segment at a time.
+class TelemetryStore : private JsonFieldVisitor {
+private:
+    struct DeviceState {
+        ColumnarSegment segment;
+        int64_t openedAt;
+        uint32_t sequence;
+    };
+
+    SegmentWriter* writer;
+    StoreLimits limits;
+    std::string tagPrefix;
+    std::unordered_map<std::string, DeviceState> devices;
+    DeviceState* current;
+    int64_t currentTime;
+    uint64_t rowsAccepted;
+
+    void beginRow() override;
+    void field(const JsonPath& path, const JsonValue& value) override;
+    void endRow() override;
+    void seal(const std::string& device, DeviceState& state);
+
+public:
+    TelemetryStore(SegmentWriter* w, const StoreLimits& l, int workerId);
+    // Returns the row count of a payload, or -1 if it is not one
+    static int validate(std::string_view body);
+    static void sanitizeDeviceId(std::string_view deviceId, std::string& out);
+    // Body must have passed validate(); deviceId must be sanitized
+    void append(const std::string& deviceId, std::string_view body, int rows, int64_t nowMs);
+    void sealExpired(int64_t nowMs);
+    void sealAll();
+    uint64_t getRowsAccepted() const;
+};
+
+#endif
@@ -0,0 +1,359 @@
+// Mentora ingest load generator
+// Simulates a fleet of devices posting a getJSONData()-shaped payload every
+// --interval-ms (the firmware uses 2000). Like the firmware's HTTPClient, each
+// POST opens a new connection by default; --keepalive holds one per device.
+// Reports sustained ingest rate and request latency percentiles.
+// Paced latency counts from each sample's scheduled time, so queueing behind
+// a stalled server shows up in the percentiles.
+// --interval-ms 0 sends back-to-back to find the ceiling.
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct BenchConfig {
+    std::string host;
+    uint16_t port;
+    int devices;
+    int threads;
+    int intervalMs;
+    int batch;
+    int durationS;
+    int warmupS;
+    bool reconnect;
+};
+
+struct DeviceConnection {
+    int fd;
+    int id;
+    bool connected;
+    bool inFlight;
+    int64_t nextSendUs;
+    int64_t sentAtUs;
+    uint32_t sequence;
+    std::string out;
+    size_t written;
+    std::string in;
+};
+
+struct ThreadResult {
+    std::vector<uint32_t> latenciesUs;
+    uint64_t completed;
+    uint64_t errors;
+    uint64_t lateSends;
+};
+
+int64_t monotonicUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Shapes and value ranges follow SensorFusion::getJSONData()
+void appendSample(std::string& body, const DeviceConnection& dev, uint32_t seq) {
+    static const char* levels[] = {"Dark", "Dim", "Good", "Bright"};
+    static const char* patterns[] = {"NONE", "TOUCH1", "TOUCH2"};
+    unsigned h = (dev.id * 2654435761u) ^ (seq * 40503u);
+    float lux = 150.0f + (h % 4000) / 10.0f;
+    float temp = 21.0f + (h % 60) / 10.0f;
+    float humidity = 40.0f + (h % 200) / 10.0f;
+    int bpm = 65 + static_cast<int>(h % 30);
+    bool stressed = bpm > 90;
+    char buf[1024];
+    int n = snprintf(buf, sizeof buf,
+        "{\"light\":{\"lux\":%.2f,\"level\":\"%s\",\"goodForStudy\":%s},"
+        "\"climate\":{\"tempC\":%.2f,\"humidity\":%.2f,\"heatIndexC\":%.2f,\"comfortable\":true,"
+        "\"recommendation\":\"Perfect temperature and humidity for studying!\"},"
+        "\"touch\":{\"pattern\":\"%s\",\"response\":\"\"},"
+        "\"heart\":{\"bpm\":%d,\"valid\":true,\"stressLevel\":%d,\"stressed\":%s},"
+        "\"tilt\":{\"tilted\":false,\"lifted\":false,\"humor\":\"\"},"
+        "\"activity\":\"%s\",\"recommendation\":\"%s\"}",
+        lux, levels[h % 4], lux > 300 ? "true" : "false",
+        temp, humidity, temp + 0.4f,
+        patterns[(h >> 8) % 3],
+        bpm, stressed ? 70 : 30, stressed ? "true" : "false",
+        (seq / 30) % 2 ? "studying" : "idle",
+        stressed ? "Take a deep breath and relax. " : "Perfect temperature and humidity for studying! ");
+    body.append(buf, static_cast<size_t>(n));
+}
+
+void buildRequest(DeviceConnection& dev, int batch) {
+    std::string body;
+    if (batch > 1) body.push_back('[');
+    for (int i = 0; i < batch; i++) {
+        if (i) body.push_back(',');
+        appendSample(body, dev, dev.sequence++);
+    }
+    if (batch > 1) body.push_back(']');
+
+    char head[256];
+    int n = snprintf(head, sizeof head,
+        "POST /api/mentora HTTP/1.1\r\nHost: mentora\r\nContent-Type: application/json\r\n"
+        "X-Device-Id: dev-%05d\r\nContent-Length: %zu\r\n\r\n", dev.id, body.size());
+    dev.out.assign(head, static_cast<size_t>(n));
+    dev.out += body;
+    dev.written = 0;
+}
+
+bool flushOut(DeviceConnection& dev) {
+    while (dev.written < dev.out.size()) {
+        ssize_t n = send(dev.fd, dev.out.data() + dev.written, dev.out.size() - dev.written, MSG_NOSIGNAL);
+        if (n > 0) { dev.written += static_cast<size_t>(n); continue; }
+        if (n < 0 && errno == EINTR) continue;
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    return true;
+}
+
+// Returns 1 when a full response was consumed, 0 if incomplete, -1 on error
+int takeResponse(DeviceConnection& dev, int& status) {
+    size_t headerEnd = dev.in.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return 0;
+    if (dev.in.compare(0, 9, "HTTP/1.1 ") != 0) return -1;
+    status = atoi(dev.in.c_str() + 9);
+    size_t length = 0;
+    size_t cl = dev.in.find("Content-Length:");
+    if (cl != std::string::npos && cl < headerEnd) length = strtoul(dev.in.c_str() + cl + 15, nullptr, 10);
+    size_t total = headerEnd + 4 + length;
+    if (dev.in.size() < total) return 0;
+    dev.in.erase(0, total);
+    return 1;
+}
+
+int openConnection(const sockaddr_in& addr) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) != 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void dropConnection(DeviceConnection& dev) {
+    close(dev.fd);
+    dev.fd = -1;
+    dev.connected = false;
+}
+
+void runThread(const BenchConfig& config, int threadIndex, int64_t startUs, ThreadResult& result) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config.port);
+    inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr);
+
+    int64_t intervalUs = static_cast<int64_t>(config.intervalMs) * 1000;
+    int64_t warmupEndUs = startUs + static_cast<int64_t>(config.warmupS) * 1000000;
+    int64_t endUs = warmupEndUs + static_cast<int64_t>(config.durationS) * 1000000;
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<DeviceConnection> devices;
+    auto watch = [&](size_t index) {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        ev.data.u64 = index;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, devices[index].fd, &ev);
+    };
+    for (int id = threadIndex; id < config.devices; id += config.threads) {
+        DeviceConnection dev{};
+        dev.id = id;
+        dev.fd = -1;
+        if (!config.reconnect) {
+            dev.fd = openConnection(addr);
+            if (dev.fd < 0) { result.errors++; continue; }
+        }
+        // Spread first sends across one interval, as a classroom powering up would
+        dev.nextSendUs = startUs + (intervalUs > 0 ? (static_cast<int64_t>(id) * 7919 % intervalUs) : 0);
+        devices.push_back(std::move(dev));
+        if (!config.reconnect) watch(devices.size() - 1);
+    }
+    // A failed request costs a keep-alive device its connection for the run;
+    // a reconnecting device just tries again on its next sample
+    auto fail = [&](DeviceConnection& dev) {
+        dropConnection(dev);
+        result.errors++;
+        if (!config.reconnect) return;
+        dev.inFlight = false;
+        dev.nextSendUs = intervalUs > 0 ? dev.nextSendUs + intervalUs : monotonicUs();
+    };
+
+    std::vector<epoll_event> events(512);
+    char chunk[4096];
+    for (;;) {
+        int64_t now = monotonicUs();
+        if (now >= endUs) break;
+
+        int64_t nextDue = endUs;
+        for (size_t i = 0; i < devices.size(); i++) {
+            DeviceConnection& dev = devices[i];
+            if (dev.inFlight || (!config.reconnect && (dev.fd < 0 || !dev.connected))) continue;
+            if (dev.nextSendUs <= now) {
+                if (config.reconnect) {
+                    dev.fd = openConnection(addr);
+                    if (dev.fd < 0) { fail(dev); continue; }
+                    dev.in.clear();
+                    watch(i);
+                }
+                buildRequest(dev, config.batch);
+                // Measure from the intended send time so server stalls that delay
+                // the schedule are counted (no coordinated omission)
+                dev.sentAtUs = intervalUs > 0 ? dev.nextSendUs : now;
+                dev.inFlight = true;
+                // A new connection sends once connect() completes (EPOLLOUT)
+                if (dev.connected && !flushOut(dev)) fail(dev);
+            } else {
+                nextDue = std::min(nextDue, dev.nextSendUs);
+            }
+        }
+
+        int timeoutMs = static_cast<int>(std::max<int64_t>(0, (nextDue - monotonicUs()) / 1000));
+        int n = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), std::min(timeoutMs, 50));
+        for (int i = 0; i < n; i++) {
+            DeviceConnection& dev = devices[events[i].data.u64];
+            if (dev.fd < 0) continue;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) { fail(dev); continue; }
+            if (events[i].events & EPOLLOUT) {
+                dev.connected = true;
+                if (dev.inFlight && !flushOut(dev)) { fail(dev); continue; }
+            }
+            if (!(events[i].events & EPOLLIN)) continue;
+            for (;;) {
+                ssize_t r = read(dev.fd, chunk, sizeof chunk);
+                if (r > 0) { dev.in.append(chunk, static_cast<size_t>(r)); continue; }
+                if (r < 0 && errno == EINTR) continue;
+                if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) fail(dev);
+                break;
+            }
+            if (dev.fd < 0) continue;
+            int status = 0;
+            int got = takeResponse(dev, status);
+            if (got < 0) { fail(dev); continue; }
+            if (got == 0) continue;
+
+            int64_t done = monotonicUs();
+            dev.inFlight = false;
+            // The firmware calls http.end() after every POST
+            if (config.reconnect) dropConnection(dev);
+            if (status != 200) result.errors++;
+            if (dev.sentAtUs >= warmupEndUs) {
+                result.completed++;
+                result.latenciesUs.push_back(static_cast<uint32_t>(std::min<int64_t>(done - dev.sentAtUs, UINT32_MAX)));
+            }
+            if (intervalUs > 0) {
+                // Keep the fixed schedule: a late device sends its next sample at once
+                dev.nextSendUs += intervalUs;
+                if (dev.nextSendUs < done) result.lateSends++;
+            } else {
+                dev.nextSendUs = done;
+            }
+        }
+    }
+    for (DeviceConnection& dev : devices) if (dev.fd >= 0) close(dev.fd);
+    close(epollFd);
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--host 127.0.0.1] [--port 8080] [--devices 2000] [--threads 4]\n"
+            "          [--interval-ms 2000] [--batch 1] [--duration-s 20] [--warmup-s 3] [--keepalive]\n",
+            argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig config{"127.0.0.1", 8080, 2000, 4, 2000, 1, 20, 3, true};
+    static const option options[] = {
+        {"host", required_argument, nullptr, 'H'},
+        {"port", required_argument, nullptr, 'p'},
+        {"devices", required_argument, nullptr, 'n'},
+        {"threads", required_argument, nullptr, 't'},
+        {"interval-ms", required_argument, nullptr, 'i'},
+        {"batch", required_argument, nullptr, 'b'},
+        {"duration-s", required_argument, nullptr, 'd'},
+        {"warmup-s", required_argument, nullptr, 'w'},
+        {"keepalive", no_argument, nullptr, 'k'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "H:p:n:t:i:b:d:w:kh", options, nullptr)) != -1) {
+        switch (opt) {
+            case 'H': config.host = optarg; break;
+            case 'p': config.port = static_cast<uint16_t>(atoi(optarg)); break;
+            case 'n': config.devices = atoi(optarg); break;
+            case 't': config.threads = atoi(optarg); break;
+            case 'i': config.intervalMs = atoi(optarg); break;
+            case 'b': config.batch = atoi(optarg); break;
+            case 'd': config.durationS = atoi(optarg); break;
+            case 'w': config.warmupS = atoi(optarg); break;
+            case 'k': config.reconnect = false; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (config.devices < 1 || config.threads < 1 || config.batch < 1 || config.durationS < 1) { usage(argv[0]); return 2; }
+
+    rlimit files;
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0) {
+        files.rlim_cur = files.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &files);
+    }
+
+    printf("%d devices on %d threads -> %s:%u, every %d ms, %d sample(s) per POST, %s, %ds (+%ds warmup)\n",
+           config.devices, config.threads, config.host.c_str(), config.port, config.intervalMs, config.batch,
+           config.reconnect ? "connection per POST" : "keep-alive", config.durationS, config.warmupS);
+    fflush(stdout);
+
+    std::vector<ThreadResult> results(config.threads);
+    std::vector<std::thread> threads;
+    int64_t startUs = monotonicUs();
+    for (int t = 0; t < config.threads; t++) {
+        threads.emplace_back(runThread, std::cref(config), t, startUs, std::ref(results[t]));
+    }
+    for (std::thread& t : threads) t.join();
+
+    std::vector<uint32_t> all;
+    uint64_t completed = 0, errors = 0, late = 0;
+    for (ThreadResult& r : results) {
+        all.insert(all.end(), r.latenciesUs.begin(), r.latenciesUs.end());
+        completed += r.completed;
+        errors += r.errors;
+        late += r.lateSends;
+    }
+    std::sort(all.begin(), all.end());
+
+    double seconds = config.durationS;
+    printf("requests:   %llu (%.0f req/s)\n", static_cast<unsigned long long>(completed), completed / seconds);
+    printf("ingest:     %.0f samples/s\n", completed * config.batch / seconds);
+    printf("latency us: p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n",
+           percentile(all, 0.50), percentile(all, 0.90), percentile(all, 0.99), percentile(all, 0.999),
+           all.empty() ? 0u : all.back());
+    printf("errors:     %llu, late sends: %llu\n", static_cast<unsigned long long>(errors), static_cast<unsigned long long>(late));
+    return errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+// Mentora ingest daemon
+// Accepts the SensorFusion::getJSONData() payload (one object, or an array of
+// them for batched uploads) on POST /api/mentora and stores it per device as
+// compressed columnar segments under --data-dir.
+//
+// Device identity: X-Device-Id header, else ?device= query, else peer address.
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <sys/resource.h>
+#include "IngestServer.h"
+
+static IngestServer* activeServer = nullptr;
+
+static void onSignal(int) {
+    if (activeServer) activeServer->stop();
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--port 8080] [--data-dir ./mentora-data] [--workers 4]\n"
+            "          [--rows-per-segment 4096] [--segment-age-ms 900000] [--max-body 65536]\n"
+            "          [--stats-ms 5000]\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    ServerConfig config;
+    config.port = 8080;
+    config.workers = 4;
+    config.maxBodyBytes = 65536;
+    config.dataDir = "./mentora-data";
+    config.limits.rowsPerSegment = 4096;
+    // ~450 rows per device at the firmware's 2 s rate; shorter windows mean
+    // more, smaller files and more syncs
+    config.limits.maxSegmentAgeMs = 900000;
+    unsigned long statsMs = 5000;
+
+    static const option options[] = {
+        {"port", required_argument, nullptr, 'p'},
+        {"data-dir", required_argument, nullptr, 'd'},
+        {"workers", required_argument, nullptr, 'w'},
+        {"rows-per-segment", required_argument, nullptr, 'r'},
+        {"segment-age-ms", required_argument, nullptr, 'a'},
+        {"max-body", required_argument, nullptr, 'b'},
+        {"stats-ms", required_argument, nullptr, 's'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:d:w:r:a:b:s:h", options, nullptr)) != -1) {
+        switch (opt) {
+            case 'p': config.port = static_cast<uint16_t>(atoi(optarg)); break;
+            case 'd': config.dataDir = optarg; break;
+            case 'w': config.workers = atoi(optarg); break;
+            case 'r': config.limits.rowsPerSegment = strtoul(optarg, nullptr, 10); break;
+            case 'a': config.limits.maxSegmentAgeMs = atol(optarg); break;
+            case 'b': config.maxBodyBytes = strtoul(optarg, nullptr, 10); break;
+            case 's': statsMs = strtoul(optarg, nullptr, 10); break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (config.workers < 1 || config.limits.rowsPerSegment < 1) { usage(argv[0]); return 2; }
+
+    // One socket per classroom device: lift the descriptor limit to the hard cap
+    rlimit files;
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0) {
+        files.rlim_cur = files.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &files);
+    }
+
+    IngestServer server(config);
+    if (!server.begin()) return 1;
+    activeServer = &server;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Mentora ingest listening on :%u, %d workers, data in %s\n", config.port, config.workers, config.dataDir.c_str());
+    fflush(stdout);
+    server.run(statsMs);
+    activeServer = nullptr;
+    return 0;
+}
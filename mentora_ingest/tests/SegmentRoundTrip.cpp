@@ -0,0 +1,154 @@
+// Encodes rows through JsonScanner + ColumnarSegment and decodes them back
+// with SegmentReader. Run via `make check`.
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include "../ColumnarSegment.h"
+#include "../SegmentReader.h"
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+    if (!condition) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+class SegmentFeeder : public JsonFieldVisitor {
+public:
+    ColumnarSegment segment;
+    int64_t nextTime = 0;
+    void beginRow() override { segment.beginRow(nextTime); }
+    void field(const JsonPath& path, const JsonValue& value) override { segment.addField(path, value); }
+    void endRow() override { segment.endRow(); }
+};
+
+void feed(SegmentFeeder& feeder, int64_t time, const std::string& body, int expectedRows) {
+    feeder.nextTime = time;
+    int rows = JsonScanner(body.data(), body.size()).scan(feeder);
+    expect(rows == expectedRows, "scanner row count");
+}
+
+const SegmentColumn* findColumn(const DecodedSegment& segment, const char* name) {
+    for (const SegmentColumn& column : segment.columns) if (column.name == name) return &column;
+    return nullptr;
+}
+
+void testRoundTrip() {
+    SegmentFeeder feeder;
+    // null value, missing column, late column, type change and nesting
+    feed(feeder, 1700000000000, "{\"a\":1.5,\"s\":\"x\",\"b\":true,\"n\":null,\"t\":1,\"light\":{\"lux\":321.25}}", 1);
+    feed(feeder, 1700000000005, "{\"a\":1.5,\"s\":\"q\\\"uote\",\"late\":7,\"t\":\"str\"}", 1);
+    // Batched array with a duplicate key: first occurrence wins
+    feed(feeder, 1700000000030, "[{\"a\":-2.25,\"s\":\"x\",\"a\":99,\"b\":false,\"light\":{\"lux\":0}},{\"a\":1e300}]", 2);
+
+    std::string encoded;
+    feeder.segment.encode(encoded);
+    DecodedSegment decoded;
+    expect(SegmentReader(encoded.data(), encoded.size()).read(decoded), "decode succeeds");
+    if (decoded.receivedAt.size() != 4) { expect(false, "four rows"); return; }
+
+    expect(decoded.receivedAt[0] == 1700000000000 && decoded.receivedAt[1] == 1700000000005 &&
+           decoded.receivedAt[2] == 1700000000030 && decoded.receivedAt[3] == 1700000000030, "receive times");
+
+    const SegmentColumn* a = findColumn(decoded, "a");
+    expect(a && a->type == JsonType::Number, "a is numeric");
+    if (a) {
+        expect(a->cells[0].present && a->cells[0].number == 1.5, "a[0]");
+        expect(a->cells[1].present && a->cells[1].number == 1.5, "a[1] repeated value");
+        expect(a->cells[2].present && a->cells[2].number == -2.25, "a[2] duplicate key keeps first");
+        expect(a->cells[3].present && a->cells[3].number == 1e300, "a[3]");
+    }
+
+    const SegmentColumn* s = findColumn(decoded, "s");
+    expect(s && s->type == JsonType::String, "s is string");
+    if (s) {
+        expect(s->cells[0].text == "x" && s->cells[2].text == "x", "s dictionary reuse");
+        expect(s->cells[1].text == "q\\\"uote", "s keeps escapes");
+        expect(!s->cells[3].present, "s missing in row 3");
+    }
+
+    const SegmentColumn* b = findColumn(decoded, "b");
+    expect(b && b->type == JsonType::Bool, "b is bool");
+    if (b) {
+        expect(b->cells[0].present && b->cells[0].boolean, "b[0]");
+        expect(!b->cells[1].present, "b missing in row 1");
+        expect(b->cells[2].present && !b->cells[2].boolean, "b[2]");
+    }
+
+    const SegmentColumn* n = findColumn(decoded, "n");
+    expect(n && n->type == JsonType::Null && !n->cells[0].present, "n stays null");
+
+    const SegmentColumn* t = findColumn(decoded, "t");
+    expect(t && t->type == JsonType::Number, "t typed by first value");
+    if (t) expect(t->cells[0].present && t->cells[0].number == 1 && !t->cells[1].present, "t type change reads null");
+
+    const SegmentColumn* late = findColumn(decoded, "late");
+    expect(late && !late->cells[0].present && late->cells[1].present && late->cells[1].number == 7, "late column backfilled");
+
+    const SegmentColumn* lux = findColumn(decoded, "light.lux");
+    expect(lux && lux->cells[0].number == 321.25 && lux->cells[2].number == 0 && !lux->cells[1].present, "nested path");
+
+    // Any truncation must be rejected, not misread
+    for (size_t cut = 0; cut < encoded.size(); cut++) {
+        DecodedSegment partial;
+        if (SegmentReader(encoded.data(), cut).read(partial)) { expect(false, "truncated segment rejected"); break; }
+    }
+}
+
+void testEmptyAndNumbers() {
+    SegmentFeeder feeder;
+    std::string encoded;
+    feeder.segment.encode(encoded);
+    DecodedSegment decoded;
+    expect(SegmentReader(encoded.data(), encoded.size()).read(decoded) && decoded.receivedAt.empty(), "empty segment");
+
+    // Irregular times and a spread of doubles exercise every XOR width
+    const double values[] = {0.0, -0.0, 1.0, 3.141592653589793, -1e-300, 65.0, 65.5, 1e15, 2.5e-7};
+    int64_t time = 5;
+    for (double v : values) {
+        char body[64];
+        snprintf(body, sizeof body, "{\"v\":%.17g}", v);
+        time += (time % 7) * 13 + 1;
+        feed(feeder, time, body, 1);
+    }
+    encoded.clear();
+    feeder.segment.encode(encoded);
+    expect(SegmentReader(encoded.data(), encoded.size()).read(decoded), "numeric decode");
+    if (decoded.columns.size() != 1) { expect(false, "one column"); return; }
+    for (size_t i = 0; i < sizeof values / sizeof values[0]; i++) {
+        double got = decoded.columns[0].cells[i].number;
+        expect(got == values[i] && std::signbit(got) == std::signbit(values[i]), "double bits preserved");
+    }
+}
+
+void testNumberGrammar() {
+    const char* valid[] = {"0", "-0", "12", "-3.25", "1e3", "1E+3", "2.5e-7", "0.5"};
+    const char* invalid[] = {"01", "-", "+1", ".5", "1.", "1e", "1e+", "inf", "-inf", "nan", "NaN", "0x10", "1e999", "--1"};
+    for (const char* number : valid) {
+        SegmentFeeder feeder;
+        feed(feeder, 0, std::string("{\"v\":") + number + "}", 1);
+    }
+    for (const char* number : invalid) {
+        SegmentFeeder feeder;
+        feed(feeder, 0, std::string("{\"v\":") + number + "}", -1);
+    }
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testEmptyAndNumbers();
+    testNumberGrammar();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    puts("segment round trip: ok");
+    return 0;
+}
@@ -0,0 +1,25 @@
+#!/bin/sh
+# Connect-per-POST run against a live daemon: every device must end up in
+# exactly one segment for the window, whichever worker accepted each POST.
+# Run via `make check`.
+set -eu
+
+DEVICES=40
+PORT=$((20000 + $$ % 20000))
+DATA=$(mktemp -d)
+trap 'rm -rf "$DATA"' EXIT
+
+./mentora_ingest --port "$PORT" --workers 4 --data-dir "$DATA" --segment-age-ms 600000 --stats-ms 60000 >/dev/null &
+SERVER=$!
+sleep 0.3
+./mentora_loadgen --port "$PORT" --devices "$DEVICES" --threads 2 --interval-ms 100 --duration-s 2 --warmup-s 0 >/dev/null
+kill -TERM "$SERVER"
+wait "$SERVER"
+
+DIRS=$(find "$DATA" -mindepth 1 -maxdepth 1 -type d | wc -l)
+SEGMENTS=$(find "$DATA" -name '*.mseg' | wc -l)
+if [ "$DIRS" -ne "$DEVICES" ] || [ "$SEGMENTS" -ne "$DEVICES" ]; then
+    echo "FAIL: $DEVICES devices wrote $SEGMENTS segments in $DIRS directories" >&2
+    exit 1
+fi
+echo "device routing: ok"
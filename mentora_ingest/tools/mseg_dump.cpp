@@ -0,0 +1,52 @@
+// Prints .mseg segments as one JSON object per row (flattened column names)
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "../SegmentReader.h"
+
+static void printString(const std::string& text) {
+    // Segment strings keep their original JSON escapes
+    putchar('"');
+    fwrite(text.data(), 1, text.size(), stdout);
+    putchar('"');
+}
+
+static bool dumpFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) { perror(path); return false; }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    DecodedSegment segment;
+    if (!SegmentReader(data.data(), data.size()).read(segment)) {
+        fprintf(stderr, "%s: not a valid segment\n", path);
+        return false;
+    }
+    for (size_t r = 0; r < segment.receivedAt.size(); r++) {
+        printf("{\"receivedAt\":%lld", static_cast<long long>(segment.receivedAt[r]));
+        for (const SegmentColumn& column : segment.columns) {
+            const SegmentCell& cell = column.cells[r];
+            printf(",\"%s\":", column.name.c_str());
+            if (!cell.present) { fputs("null", stdout); continue; }
+            switch (column.type) {
+                case JsonType::Number: printf("%.17g", cell.number); break;
+                case JsonType::Bool: fputs(cell.boolean ? "true" : "false", stdout); break;
+                case JsonType::String: printString(cell.text); break;
+                case JsonType::Null: fputs("null", stdout); break;
+            }
+        }
+        puts("}");
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s segment.mseg...\n", argv[0]);
+        return 2;
+    }
+    bool ok = true;
+    for (int i = 1; i < argc; i++) ok = dumpFile(argv[i]) && ok;
+    return ok ? 0 : 1;
+}
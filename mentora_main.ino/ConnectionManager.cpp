@@ -0,0 +1,92 @@
+#include "ConnectionManager.h"
+
+ConnectionManager::ConnectionManager() : ssid(nullptr), password(nullptr), state(CONN_IDLE), stateSince(0), retryDelay(0), failedAttempts(0), connectedEdge(false), disconnectedEdge(false) {}
+
+void ConnectionManager::begin(const char* networkSsid, const char* networkPassword) {
+    ssid = networkSsid;
+    password = networkPassword;
+    WiFi.mode(WIFI_STA);
+    // Reconnects are paced by the backoff below, not by the driver
+    WiFi.setAutoReconnect(false);
+    startAttempt();
+}
+
+void ConnectionManager::startAttempt() {
+    WiFi.begin(ssid, password);
+    state = CONN_CONNECTING;
+    stateSince = millis();
+}
+
+void ConnectionManager::scheduleRetry() {
+    WiFi.disconnect();
+    retryDelay = jitteredBackoff(failedAttempts, BACKOFF_MIN, BACKOFF_MAX);
+    if (failedAttempts < 255) failedAttempts++;
+    state = CONN_BACKOFF;
+    stateSince = millis();
+}
+
+void ConnectionManager::update() {
+    unsigned long now = millis();
+    switch (state) {
+        case CONN_IDLE:
+            break;
+        case CONN_CONNECTING:
+            if (WiFi.status() == WL_CONNECTED) {
+                state = CONN_CONNECTED;
+                stateSince = now;
+                failedAttempts = 0;
+                connectedEdge = true;
+            } else if (now - stateSince >= CONNECT_TIMEOUT) {
+                scheduleRetry();
+            }
+            break;
+        case CONN_CONNECTED:
+            if (WiFi.status() != WL_CONNECTED) {
+                disconnectedEdge = true;
+                scheduleRetry();
+            }
+            break;
+        case CONN_BACKOFF:
+            if (now - stateSince >= retryDelay) startAttempt();
+            break;
+    }
+}
+
+bool ConnectionManager::isConnected() { return state == CONN_CONNECTED; }
+
+bool ConnectionManager::justConnected() {
+    bool edge = connectedEdge;
+    connectedEdge = false;
+    return edge;
+}
+
+bool ConnectionManager::justDisconnected() {
+    bool edge = disconnectedEdge;
+    disconnectedEdge = false;
+    return edge;
+}
+
+ConnectionState ConnectionManager::getState() { return state; }
+
+String ConnectionManager::getStateName() {
+    switch (state) {
+        case CONN_CONNECTING: return "connecting";
+        case CONN_CONNECTED: return "connected";
+        case CONN_BACKOFF: return "backoff";
+        default: return "idle";
+    }
+}
+
+unsigned long ConnectionManager::getRetryInMs() {
+    if (state != CONN_BACKOFF) return 0;
+    unsigned long elapsed = millis() - stateSince;
+    return elapsed >= retryDelay ? 0 : retryDelay - elapsed;
+}
+
+unsigned int ConnectionManager::getFailedAttempts() { return failedAttempts; }
+
+unsigned long ConnectionManager::jitteredBackoff(unsigned int failures, unsigned long minMs, unsigned long maxMs) {
+    unsigned long step = minMs << min(failures, 16u);
+    if (step > maxMs || step < minMs) step = maxMs;
+    return step / 2 + random(step / 2 + 1);
+}
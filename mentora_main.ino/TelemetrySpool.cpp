@@ -0,0 +1,213 @@
+#include "TelemetrySpool.h"
+
+TelemetrySpool::TelemetrySpool() : ramHead(0), ramCount(0), flashReady(false), fileHead(0), fileTail(0), tailRecords(0), flashRecords(0), headOffset(0), bootFileLimit(0), dropped(0), pendingFromFlash(false), pendingCount(0), pendingLines(0), pendingSkipped(0), pendingOffset(0), pendingHeadDone(false) {}
+
+bool TelemetrySpool::begin() {
+    flashReady = LittleFS.begin(true);
+    if (!flashReady) return false;
+    if (!LittleFS.exists("/spool")) LittleFS.mkdir("/spool");
+    recoverFiles();
+    return true;
+}
+
+String TelemetrySpool::filePath(uint32_t index) {
+    return "/spool/" + String(index) + ".log";
+}
+
+// A record is "<millis>\t<json object>". Serialized JSON escapes tabs, so a
+// second tab means a torn write was glued to the next record.
+static bool isCompleteRecord(const String& line, bool terminated) {
+    if (!terminated) return false;
+    int tab = line.indexOf('\t');
+    if (tab <= 0 || line.indexOf('\t', tab + 1) >= 0) return false;
+    for (int i = 0; i < tab; i++) if (!isDigit(line[i])) return false;
+    int last = (int)line.length() - 1;
+    return last > tab + 1 && line[tab + 1] == '{' && line[last] == '}';
+}
+
+static uint32_t countLines(File& f) {
+    uint8_t buf[128];
+    uint32_t lines = 0;
+    while (f.available()) {
+        int n = f.read(buf, sizeof(buf));
+        if (n <= 0) break;
+        for (int i = 0; i < n; i++) if (buf[i] == '\n') lines++;
+    }
+    return lines;
+}
+
+void TelemetrySpool::recoverFiles() {
+    // Records left over from before a reboot are sent first, at least once
+    File dir = LittleFS.open("/spool");
+    bool found = false;
+    uint32_t lowest = 0, highest = 0;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        String name = f.name();
+        int slash = name.lastIndexOf('/');
+        if (slash >= 0) name = name.substring(slash + 1);
+        uint32_t index = (uint32_t)name.toInt();
+        flashRecords += countLines(f);
+        if (!found || index < lowest) lowest = index;
+        if (!found || index > highest) highest = index;
+        found = true;
+    }
+    fileHead = found ? lowest : 0;
+    fileTail = found ? highest + 1 : 0;
+    bootFileLimit = fileTail;
+    tailRecords = 0;
+    headOffset = 0;
+}
+
+void TelemetrySpool::dropHeadFile() {
+    File f = LittleFS.open(filePath(fileHead), FILE_READ);
+    uint32_t lost = 0;
+    if (f) {
+        f.seek(headOffset);
+        lost = countLines(f);
+        f.close();
+    }
+    LittleFS.remove(filePath(fileHead));
+    lost = min(lost, flashRecords);
+    flashRecords -= lost;
+    dropped += lost;
+    fileHead++;
+    headOffset = 0;
+}
+
+void TelemetrySpool::spillOldestToFlash() {
+    Record& oldest = ram[ramHead];
+    bool saved = false;
+    if (flashReady) {
+        File f = LittleFS.open(filePath(fileTail), FILE_APPEND);
+        if (f) {
+            String line = String(oldest.capturedAt) + "\t" + oldest.json + "\n";
+            // A short write leaves a torn line that peekBatch() skips
+            saved = f.print(line) == line.length();
+            f.close();
+        }
+        if (saved) {
+            flashRecords++;
+            if (++tailRecords >= RECORDS_PER_FILE) {
+                fileTail++;
+                tailRecords = 0;
+                if (fileTail - fileHead >= MAX_FILES) dropHeadFile();
+            }
+        }
+    }
+    if (!saved) dropped++;
+    oldest.json = String();
+    ramHead = (ramHead + 1) % RAM_CAPACITY;
+    ramCount--;
+}
+
+void TelemetrySpool::push(const String& json) {
+    if (ramCount == RAM_CAPACITY) spillOldestToFlash();
+    Record& slot = ram[(ramHead + ramCount) % RAM_CAPACITY];
+    slot.capturedAt = millis();
+    slot.json = json;
+    ramCount++;
+}
+
+bool TelemetrySpool::isEmpty() { return size() == 0; }
+
+size_t TelemetrySpool::size() { return (size_t)ramCount + flashRecords; }
+
+void TelemetrySpool::appendRecord(String& batch, unsigned long capturedAt, const String& json, bool ageKnown) {
+    if (batch.length() > 1) batch += ',';
+    if (ageKnown && json.length() > 2 && json[0] == '{') {
+        // Lets the backend recover capture time from its receive time
+        batch += "{\"ageMs\":";
+        batch += String(millis() - capturedAt);
+        batch += ',';
+        batch += json.c_str() + 1;
+    } else {
+        batch += json;
+    }
+}
+
+String TelemetrySpool::peekBatch(int maxRecords) {
+    String batch = "[";
+    pendingCount = 0;
+    while (flashReady && flashRecords > 0) {
+        pendingFromFlash = true;
+        pendingOffset = headOffset;
+        pendingHeadDone = true;
+        pendingLines = 0;
+        pendingSkipped = 0;
+        File f = LittleFS.open(filePath(fileHead), FILE_READ);
+        bool opened = (bool)f;
+        if (f) {
+            f.seek(headOffset);
+            bool ageKnown = fileHead >= bootFileLimit;
+            while (pendingCount < maxRecords && f.available()) {
+                size_t start = f.position();
+                String line = f.readStringUntil('\n');
+                pendingOffset = f.position();
+                // readStringUntil() also returns a final line cut off by a power loss
+                bool terminated = pendingOffset - start > line.length();
+                if (terminated) pendingLines++;
+                if (isCompleteRecord(line, terminated)) {
+                    int tab = line.indexOf('\t');
+                    appendRecord(batch, strtoul(line.c_str(), nullptr, 10), line.substring(tab + 1), ageKnown);
+                    pendingCount++;
+                } else {
+                    pendingSkipped++;
+                }
+            }
+            pendingHeadDone = !f.available();
+            f.close();
+        }
+        if (pendingCount > 0) return batch + "]";
+        // Only torn lines, or an empty or missing head file: retire them and look again
+        bool wasTail = fileHead == fileTail;
+        commit();
+        if (!opened && wasTail) flashRecords = 0;
+    }
+
+    pendingFromFlash = false;
+    for (int i = 0; i < ramCount && pendingCount < maxRecords; i++) {
+        Record& r = ram[(ramHead + i) % RAM_CAPACITY];
+        appendRecord(batch, r.capturedAt, r.json, true);
+        pendingCount++;
+    }
+    return batch + "]";
+}
+
+void TelemetrySpool::commit() {
+    if (pendingFromFlash) {
+        // Only newline-terminated lines were ever counted into flashRecords
+        flashRecords -= min(pendingLines, flashRecords);
+        dropped += pendingSkipped;
+        headOffset = pendingOffset;
+        if (pendingHeadDone) {
+            LittleFS.remove(filePath(fileHead));
+            // Finished the file still being appended to: start a fresh one
+            if (fileHead == fileTail) {
+                fileTail++;
+                tailRecords = 0;
+            }
+            fileHead++;
+            headOffset = 0;
+        }
+    } else {
+        for (int i = 0; i < pendingCount && ramCount > 0; i++) {
+            ram[ramHead].json = String();
+            ramHead = (ramHead + 1) % RAM_CAPACITY;
+            ramCount--;
+        }
+    }
+    pendingCount = 0;
+    pendingLines = 0;
+    pendingSkipped = 0;
+    pendingFromFlash = false;
+}
+
+void TelemetrySpool::discard() {
+    // A batch the backend refuses will never succeed; retrying it would stall the backlog
+    dropped += pendingCount;
+    commit();
+}
+
+int TelemetrySpool::getPendingCount() { return pendingCount; }
+
+unsigned long TelemetrySpool::getDropped() { return dropped; }
@@ -0,0 +1,64 @@
+#ifndef MENTORA_TELEMETRY_SPOOL_H
+#define MENTORA_TELEMETRY_SPOOL_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+// Store-and-forward buffer for telemetry posted while offline.
+// Newest samples stay in a RAM ring; when it fills, the oldest spill to
+// numbered LittleFS files under /spool. Both tiers are bounded and drop the
+// oldest data first. Drain with peekBatch() then commit() (sent) or discard()
+// (rejected by the backend) before the next push().
+class TelemetrySpool {
+private:
+    struct Record {
+        unsigned long capturedAt;
+        String json;
+    };
+
+    static const int RAM_CAPACITY = 30;        // one minute at the 2 s post rate
+    static const uint32_t RECORDS_PER_FILE = 30;
+    static const uint32_t MAX_FILES = 24;      // ~12 more minutes on flash
+
+    Record ram[RAM_CAPACITY];
+    int ramHead;
+    int ramCount;
+
+    bool flashReady;
+    uint32_t fileHead;      // oldest file still holding unsent records
+    uint32_t fileTail;      // file currently appended to
+    uint32_t tailRecords;
+    uint32_t flashRecords;
+    size_t headOffset;
+    uint32_t bootFileLimit; // files below this were written before reboot
+    unsigned long dropped;
+
+    bool pendingFromFlash;
+    int pendingCount;
+    uint32_t pendingLines;   // newline-terminated flash lines consumed
+    uint32_t pendingSkipped; // torn or corrupt flash lines consumed
+    size_t pendingOffset;
+    bool pendingHeadDone;
+
+    String filePath(uint32_t index);
+    void recoverFiles();
+    void spillOldestToFlash();
+    void dropHeadFile();
+    void appendRecord(String& batch, unsigned long capturedAt, const String& json, bool ageKnown);
+
+public:
+    TelemetrySpool();
+    bool begin();
+    void push(const String& json);
+    bool isEmpty();
+    size_t size();
+    // JSON array of the oldest records, each tagged with "ageMs" when known
+    String peekBatch(int maxRecords);
+    void commit();
+    void discard();
+    // Records in the last peekBatch() not yet committed or discarded
+    int getPendingCount();
+    unsigned long getDropped();
+};
+
+#endif
@@ -18,6 +18,8 @@
 #include "sensors/TiltSwitch.h"
 #include "TTP223Touch.h"
 #include "SensorFusion.h"
+#include "ConnectionManager.h"
+#include "TelemetrySpool.h"
 
 // WiFi
 const char* ssid = "YOUR_WIFI_SSID";
@@ -62,6 +64,10 @@ TiltSwitch tiltSensor(TILT_PIN);
 TTP223Touch touchSensor(TOUCH2_PIN, TOUCH3_PIN);
 SensorFusion fusion;
 
+// Connectivity
+ConnectionManager connection;
+TelemetrySpool spool;
+
 // Emotions
 String currentEmotion = "DEFAULT";
 String baseEmotion = "DEFAULT";
@@ -79,11 +85,33 @@ const unsigned long reactionAnimationDuration = 3000;
 
 unsigned long lastPost = 0;
 const unsigned long POST_INTERVAL = 2000; // 2 seconds
+// Short timeouts: posting runs inside loop(), and the backend is on the LAN
+const unsigned long HTTP_CONNECT_TIMEOUT = 300;
+const unsigned long HTTP_READ_TIMEOUT = 1000;
+
+// Backlog drain after an outage: one batch per POST_INTERVAL carrying the live
+// sample too, so recovery sends no more requests than normal traffic
+const int DRAIN_BATCH = 10;
+int drainBatchSize = DRAIN_BATCH;
+int isolateRemaining = 0; // records of a rejected batch still to resend singly
+unsigned long rejectedSamples = 0;
+const unsigned long DRAIN_RETRY_MIN = 2000;
+const unsigned long DRAIN_RETRY_MAX = 60000;
+unsigned int drainFailures = 0;
+const unsigned long DRAIN_WINDOW_MAX = 300000;
+unsigned long drainHoldStart = 0; // no drain until drainHoldMs after this
+unsigned long drainHoldMs = 0;
 
 // Forward declarations
 void initializeDisplay();
 void initializeRoboEyes();
 void setupWebServer();
+void serviceTelemetry();
+void holdDrain(unsigned long ms);
+void backOffDrain();
+unsigned long drainStartWindow();
+int postTelemetry(const String& body);
+bool isPostRejected(int code);
 void displayEmotion();
 String parseBaseEmotion(String emotion);
 bool isReactionEmotion(String emotion);
@@ -129,13 +157,10 @@ void setup() {
   fusion.attachSensors(&lightSensor, &touchSensor, &heartSensor, &tiltSensor, &climateSensor);
   fusion.begin();
 
-  // WiFi
-  WiFi.begin(ssid, password);
-  Serial.print("Connecting to WiFi");
-  while (WiFi.status() != WL_CONNECTED) { delay(500); Serial.print("."); }
-  Serial.println();
-  Serial.print("WiFi connected: "); Serial.println(WiFi.localIP());
-  digitalWrite(LED_PIN, HIGH);
+  // Telemetry spool + WiFi (connects in the background, see serviceTelemetry)
+  if (!spool.begin()) Serial.println("Spool flash unavailable, buffering in RAM only");
+  connection.begin(ssid, password);
+  Serial.println("Connecting to WiFi...");
 
   // Web server
   setupWebServer();
@@ -147,6 +172,7 @@ void setup() {
 void loop() {
   // Web requests
   server.handleClient();
+  connection.update();
 
   // Update sensors
   lightSensor.updateReading();
@@ -169,24 +195,8 @@ void loop() {
   }
   updateAnimations();
 
-  // Prepare JSON
-  String payload = fusion.getJSONData();
-
-  // POST every 2s
-  if (WiFi.status() == WL_CONNECTED && millis() - lastPost >= POST_INTERVAL) {
-    lastPost = millis();
-    HTTPClient http;
-    http.begin(postUrl);
-    http.addHeader("Content-Type", "application/json");
-    int code = http.POST(payload);
-    if (code > 0) {
-      String resp = http.getString();
-      Serial.print("POST "); Serial.print(code); Serial.print(" -> "); Serial.println(resp);
-    } else {
-      Serial.print("HTTP POST failed: "); Serial.println(code);
-    }
-    http.end();
-  }
+  // Telemetry every 2s, spooled while offline
+  serviceTelemetry();
 
   delay(10);
 }
@@ -223,6 +233,10 @@ void setupWebServer() {
     doc["has_reaction"] = hasReaction;
     doc["ip"] = WiFi.localIP().toString();
     doc["uptime"] = millis();
+    doc["wifi"] = connection.getStateName();
+    doc["spooled"] = spool.size();
+    doc["dropped"] = spool.getDropped();
+    doc["rejected"] = rejectedSamples;
     String res; serializeJson(doc, res);
     server.send(200, "application/json", res);
   });
@@ -273,6 +287,112 @@ void setupWebServer() {
   Serial.println("Web server started");
 }
 
+// ===== Telemetry =====
+void serviceTelemetry() {
+  unsigned long now = millis();
+  if (connection.justConnected()) {
+    Serial.print("WiFi connected: "); Serial.println(WiFi.localIP());
+    digitalWrite(LED_PIN, HIGH);
+    // Stagger the backlog so a classroom recovering together does not post at once
+    holdDrain(random(drainStartWindow()));
+  }
+  if (connection.justDisconnected()) {
+    Serial.println("WiFi lost, spooling telemetry");
+    digitalWrite(LED_PIN, LOW);
+  }
+
+  if (now - lastPost < POST_INTERVAL) return;
+  lastPost = now;
+  String payload = fusion.getJSONData();
+
+  if (spool.isEmpty() && connection.isConnected()) {
+    int code = postTelemetry(payload);
+    if (code >= 200 && code < 300) return;
+    if (isPostRejected(code)) { rejectedSamples++; return; }
+    // Backend unreachable with Wi-Fi up: start a backlog and retry it later
+    spool.push(payload);
+    backOffDrain();
+    return;
+  }
+
+  // Behind a backlog, new samples queue up too so order is kept
+  if (!connection.isConnected() || millis() - drainHoldStart < drainHoldMs) { spool.push(payload); return; }
+
+  String batch = spool.peekBatch(drainBatchSize);
+  bool withLive = drainBatchSize > 1;
+  if (withLive) {
+    batch.remove(batch.length() - 1);
+    if (batch.length() > 1) batch += ',';
+    batch += payload;
+    batch += ']';
+  }
+  int code = postTelemetry(batch);
+  if (code >= 200 && code < 300) {
+    spool.commit();
+    if (!withLive) spool.push(payload);
+    if (!withLive && --isolateRemaining <= 0) drainBatchSize = DRAIN_BATCH;
+    drainFailures = 0;
+    holdDrain(0);
+  } else if (isPostRejected(code)) {
+    // One bad record fails the whole array: resend its records singly until
+    // each has been sent or dropped, so the bad one is found
+    if (withLive && spool.getPendingCount() == 0) {
+      rejectedSamples++; // the live sample went alone and was refused
+    } else if (withLive) {
+      isolateRemaining = spool.getPendingCount();
+      drainBatchSize = 1;
+      spool.push(payload);
+    } else {
+      spool.discard();
+      spool.push(payload);
+      if (--isolateRemaining <= 0) drainBatchSize = DRAIN_BATCH;
+    }
+  } else {
+    // Transport error or 5xx: the backend may recover, keep the batch and back off
+    spool.push(payload);
+    backOffDrain();
+  }
+}
+
+void holdDrain(unsigned long ms) {
+  drainHoldStart = millis();
+  drainHoldMs = ms;
+}
+
+void backOffDrain() {
+  holdDrain(ConnectionManager::jitteredBackoff(drainFailures, DRAIN_RETRY_MIN, DRAIN_RETRY_MAX));
+  if (drainFailures < 255) drainFailures++;
+}
+
+// About as long as the backlog takes to drain, so staggered starts keep the
+// extra load of a recovering classroom close to its normal traffic
+unsigned long drainStartWindow() {
+  unsigned long window = (spool.size() / DRAIN_BATCH + 1) * POST_INTERVAL;
+  return min(window, DRAIN_WINDOW_MAX);
+}
+
+// Only codes that refuse the payload itself justify dropping data. Other 4xx
+// (auth, wrong URL, throttling) can clear up and are retried like 5xx.
+bool isPostRejected(int code) { return code == 400 || code == 413 || code == 415 || code == 422; }
+
+int postTelemetry(const String& body) {
+  HTTPClient http;
+  http.setConnectTimeout(HTTP_CONNECT_TIMEOUT);
+  http.setTimeout(HTTP_READ_TIMEOUT);
+  http.begin(postUrl);
+  http.addHeader("Content-Type", "application/json");
+  http.addHeader("X-Device-Id", WiFi.macAddress());
+  int code = http.POST(body);
+  if (code > 0) {
+    String resp = http.getString();
+    Serial.print("POST "); Serial.print(code); Serial.print(" -> "); Serial.println(resp);
+  } else {
+    Serial.print("HTTP POST failed: "); Serial.println(code);
+  }
+  http.end();
+  return code;
+}
+
 // ===== Emotions =====
 String parseBaseEmotion(String emotion) {
   if (emotion.endsWith("_REACTION")) return emotion.substring(0, emotion.indexOf("_REACTION"));